@@ -10,13 +10,33 @@
 // --------------------------------------------------------------------------------------------------------------------
 
 #include "bintree.h"
+#include "treelog.h"
 #include <queue>
+#include <algorithm>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+// ------------------------------------prefetch-----------------------------------------------
+// Description: asks the cache to start loading the given address without waiting for it
+// ---------------------------------------------------------------------------------------------------
+static inline void prefetch(const void* address)
+{
+#if defined(__GNUC__)
+	__builtin_prefetch(address);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	_mm_prefetch((const char*)address, _MM_HINT_T0);
+#else
+	(void)address;
+#endif
+}
 
 // ------------------------------------<<-----------------------------------------------
 // Description: Prints tree contents in-order from smallest to largest
 // ---------------------------------------------------------------------------------------------------
 std::ostream & operator<<(std::ostream & out, const BinTree & tree)
 {
+	tree.ensureBuilt();
 	tree.inorderHelper(tree.root, out);
 	out << std::endl;
 	return out;
@@ -29,6 +49,9 @@ BinTree::BinTree()
 {
 	this->root = nullptr;
 	this->size = 0;
+	this->log = nullptr;
+	this->bulkLoading = false;
+	this->bulkDuplicates = 0;
 }
 
 // ------------------------------------BinTree-----------------------------------------------
@@ -36,13 +59,19 @@ BinTree::BinTree()
 // ---------------------------------------------------------------------------------------------------
 BinTree::BinTree(const BinTree& other)
 {
+	other.ensureBuilt();
 	this->root = new Node;
 	NodeData* otherRootNodeData = new NodeData(*other.root->data);
 	this->root->data = otherRootNodeData;
 	this->root->left = nullptr;
 	this->root->right = nullptr;
+	this->root->keyHash = other.root->keyHash;
+	this->root->hash = other.root->hash;
 	deepCopy(other.root, this->root);
 	this->size = other.size;
+	this->log = nullptr;
+	this->bulkLoading = false;
+	this->bulkDuplicates = 0;
 }
 
 // ------------------------------------~BinTree-----------------------------------------------
@@ -50,6 +79,10 @@ BinTree::BinTree(const BinTree& other)
 // ---------------------------------------------------------------------------------------------------
 BinTree::~BinTree()
 {
+	if (this->log != nullptr)
+	{
+		this->log->close();				// detaches, so the makeEmpty below is not logged
+	}
 	makeEmpty();
 	//deleteSubTree(this->root);
 }
@@ -59,7 +92,7 @@ BinTree::~BinTree()
 // ---------------------------------------------------------------------------------------------------
 bool BinTree::isEmpty() const
 {
-	if (this->root == nullptr)
+	if (this->root == nullptr && this->pending.empty())
 	{
 		return true;
 	}
@@ -71,9 +104,18 @@ bool BinTree::isEmpty() const
 // ---------------------------------------------------------------------------------------------------
 void BinTree::makeEmpty()
 {
+	for (NodeData* data : this->pending)
+	{
+		delete data;
+	}
+	this->pending.clear();
 	deleteSubTree(this->root);
 	this->root = nullptr;
 	this->size = 0;
+	if (this->log != nullptr)
+	{
+		this->log->logClear();
+	}
 }
 
 // ------------------------------------=operator-----------------------------------------------
@@ -83,22 +125,40 @@ BinTree & BinTree::operator=(const BinTree & other)
 {
 	if (this != &other)
 	{
+		other.ensureBuilt();
+		for (NodeData* data : this->pending)
+		{
+			delete data;
+		}
+		this->pending.clear();
 		deleteSubTree(this->root);
 		this->root = new Node;
 		this->root->data = new NodeData(*other.root->data);
 		this->root->left = nullptr;
 		this->root->right = nullptr;
+		this->root->keyHash = other.root->keyHash;
+		this->root->hash = other.root->hash;
 		deepCopy(other.root, this->root);
+		this->size = other.size;
+		if (this->log != nullptr)
+		{
+			this->log->logClear();
+			logPreorder(this->root);
+		}
 	}
 	return (*this);
 }
 
 // ------------------------------------==operator-----------------------------------------------
-// Description: determines if two binary trees are equivalent
+// Description: determines if two binary trees are equivalent. Trees with different fingerprints are
+// rejected in O(1), a full walk only confirms a match
 // ---------------------------------------------------------------------------------------------------
 bool BinTree::operator==(const BinTree & other) const
 {
 	if (this == &other) return true;
+	ensureBuilt();
+	other.ensureBuilt();
+	if (subTreeHash(this->root) != subTreeHash(other.root)) return false;
 	return subTreeEqual(this->root, other.root);
 }
 
@@ -111,31 +171,51 @@ bool BinTree::operator!=(const BinTree & other) const
 }
 
 // ------------------------------------insert-----------------------------------------------
-// Description: inserts data into the binary tree
+// Description: inserts data into the binary tree. During a bulk load the tree takes ownership of data
+// and returns true, duplicates are deleted when the tree is built and reported to the duplicate handler
 // ---------------------------------------------------------------------------------------------------
 bool BinTree::insert(NodeData * data)
 {
 	if (data == nullptr) return false;
+	if (this->bulkLoading)
+	{
+		this->pending.push_back(data);
+		if (this->log != nullptr) this->log->logInsert(*data);
+		return true;
+	}
 	Node* newDataNodePtr = new Node;
 	newDataNodePtr->data = data;
 	newDataNodePtr->left = nullptr;
 	newDataNodePtr->right = nullptr;
+	this->insertPath.clear();
 		if (this->root == nullptr)
 	{
+		newDataNodePtr->keyHash = hashKey(data->getData());
+		rehash(newDataNodePtr);
 		this->root = newDataNodePtr;
 		this->size = 1;
+		if (this->log != nullptr) this->log->logInsert(*data);
 		return true;
 	} else
 	{
 		Node* currentNode = this->root;
 		while (true)
 		{
+			this->insertPath.push_back(currentNode);
 			if (*data < *currentNode->data)
 			{
 				if (currentNode->left == nullptr)
 				{
+					// hashed only once the slot is found, a duplicate never pays for it
+					newDataNodePtr->keyHash = hashKey(data->getData());
+					rehash(newDataNodePtr);
 					currentNode->left = newDataNodePtr;
 					this->size++;
+					for (size_t i = this->insertPath.size(); i > 0; i--)
+					{
+						rehash(this->insertPath[i - 1]);
+					}
+					if (this->log != nullptr) this->log->logInsert(*data);
 					return true;
 				} else
 				{
@@ -145,8 +225,15 @@ bool BinTree::insert(NodeData * data)
 			{
 				if (currentNode->right == nullptr)
 				{
+					newDataNodePtr->keyHash = hashKey(data->getData());
+					rehash(newDataNodePtr);
 					currentNode->right = newDataNodePtr;
 					this->size++;
+					for (size_t i = this->insertPath.size(); i > 0; i--)
+					{
+						rehash(this->insertPath[i - 1]);
+					}
+					if (this->log != nullptr) this->log->logInsert(*data);
 					return true;
 				} else
 				{
@@ -167,6 +254,7 @@ bool BinTree::insert(NodeData * data)
 // ---------------------------------------------------------------------------------------------------
 bool BinTree::retrieve(const NodeData& data, NodeData* & actual) const
 {
+	ensureBuilt();
 	Node* currentNode = this->root;
 	while (currentNode != nullptr)
 	{
@@ -186,11 +274,46 @@ bool BinTree::retrieve(const NodeData& data, NodeData* & actual) const
 	return false;
 }
 
+#if defined(__cpp_impl_coroutine)
+// ------------------------------------asyncRetrieve-----------------------------------------------
+// Description: retrieve as a coroutine that prefetches and suspends before each memory access down the
+// tree, see retrievetask.h. data is copied into the task, actual must outlive it and the tree must not
+// change meanwhile
+// ---------------------------------------------------------------------------------------------------
+RetrieveTask BinTree::asyncRetrieve(NodeData data, NodeData* & actual) const
+{
+	ensureBuilt();
+	const Node* currentNode = this->root;
+	while (currentNode != nullptr)
+	{
+		// a level is two dependent loads, the node and then the NodeData it points at
+		prefetch(currentNode);
+		co_await std::suspend_always();
+		prefetch(currentNode->data);
+		co_await std::suspend_always();
+		if (data < *currentNode->data)
+		{
+			currentNode = currentNode->left;
+		} else if (data > *currentNode->data)
+		{
+			currentNode = currentNode->right;
+		} else
+		{
+			actual = currentNode->data;
+			co_return true;
+		}
+	}
+	actual = nullptr;
+	co_return false;
+}
+#endif
+
 // ------------------------------------getHeight-----------------------------------------------
 // Description:finds height of a given value in the tree
 // ---------------------------------------------------------------------------------------------------
 int BinTree::getHeight(const NodeData & data) const
 {
+	ensureBuilt();
 	bool nodeFound = false;
 	Node* currentNode;
 	currentNode = this->root;
@@ -225,7 +348,16 @@ int BinTree::getHeight(const NodeData & data) const
 // Postconditions: BinTree remains unchanged.
 void BinTree::displaySideways() const
 {
-	sideways(root, 0);
+	displaySideways(cout);
+}
+
+// ------------------------------------displaySideways-----------------------------------------------
+// Description: displays the tree sideways to the given stream
+// ---------------------------------------------------------------------------------------------------
+void BinTree::displaySideways(std::ostream & out) const
+{
+	ensureBuilt();
+	sideways(root, 0, out);
 }
 
 // ------------------------------------bstreeToArray-----------------------------------------------
@@ -233,6 +365,7 @@ void BinTree::displaySideways() const
 // ---------------------------------------------------------------------------------------------------
 void BinTree::bstreeToArray(NodeData *resultArray[])
 {
+	ensureBuilt();
 	vector<NodeData*> resultVector;
 	toArrayInorderHelper(this->root, resultVector);
 	int count = 0;
@@ -266,6 +399,114 @@ void BinTree::arrayToBSTree(NodeData *input[])
 	}
 }
 
+// ------------------------------------findPrefix-----------------------------------------------
+// Description: visits, smallest to largest, every value that starts with the given prefix and returns how
+// many were visited. Runs in O(height + matches)
+// ---------------------------------------------------------------------------------------------------
+int BinTree::findPrefix(const string & prefix, const std::function<void(const NodeData&)>& visit) const
+{
+	ensureBuilt();
+	int count = 0;
+	prefixWalk(this->root, prefix, 0, 0, visit, count);
+	return count;
+}
+
+// ------------------------------------longestCommonPrefix-----------------------------------------------
+// Description: finds the value sharing the longest prefix with the given string, returns the length of
+// that shared prefix and points actual at the value (nullptr when the tree is empty)
+// ---------------------------------------------------------------------------------------------------
+int BinTree::longestCommonPrefix(const string & query, NodeData* & actual) const
+{
+	ensureBuilt();
+	// the best match is the in-order predecessor or successor of query, both lie on the search path
+	actual = nullptr;
+	int best = -1;
+	size_t lowLcp = 0;
+	size_t highLcp = 0;
+	Node* currentNode = this->root;
+	while (currentNode != nullptr)
+	{
+		size_t lcp = min(lowLcp, highLcp);
+		int side = comparePrefix(query, currentNode->data->getData(), lcp);
+		if ((int)lcp > best)
+		{
+			best = (int)lcp;
+			actual = currentNode->data;
+		}
+		if (side < 0)
+		{
+			lowLcp = lcp;
+			currentNode = currentNode->right;
+		} else if (side > 0)
+		{
+			highLcp = lcp;
+			currentNode = currentNode->left;
+		} else
+		{
+			break;
+		}
+	}
+	return (best < 0) ? 0 : best;
+}
+
+// ------------------------------------attachLog-----------------------------------------------
+// Description: sets the write-ahead log that successful inserts and makeEmpty are recorded to, nullptr
+// stops logging. Called by TreeLog::open and TreeLog::close
+// ---------------------------------------------------------------------------------------------------
+void BinTree::attachLog(TreeLog * log)
+{
+	this->log = log;
+}
+
+// ------------------------------------beginBulkLoad-----------------------------------------------
+// Description: starts deferred building, insert appends to an unsorted buffer in O(1) and the next
+// read sorts the buffer, drops duplicates and rebuilds a balanced tree in one pass. onDuplicate, if
+// given, sees each duplicate before it is deleted. The reads that build are const but change the tree
+// and run onDuplicate, so while data is pending they must not run on several threads at once. A tree
+// declared const never has pending data, its copy constructor builds the source first
+// ---------------------------------------------------------------------------------------------------
+void BinTree::beginBulkLoad(const std::function<void(const NodeData&)>& onDuplicate)
+{
+	this->bulkLoading = true;
+	this->duplicateHandler = onDuplicate;
+	this->bulkDuplicates = 0;
+}
+
+// ------------------------------------endBulkLoad-----------------------------------------------
+// Description: builds anything still buffered, returns to normal inserts and returns how many
+// duplicates were dropped since beginBulkLoad
+// ---------------------------------------------------------------------------------------------------
+int BinTree::endBulkLoad()
+{
+	ensureBuilt();
+	this->bulkLoading = false;
+	this->duplicateHandler = nullptr;
+	return this->bulkDuplicates;
+}
+
+// ------------------------------------fingerprint-----------------------------------------------
+// Description: returns a hash of every value and the shape of the tree, equal trees have equal
+// fingerprints on every platform
+// ---------------------------------------------------------------------------------------------------
+uint64_t BinTree::fingerprint() const
+{
+	ensureBuilt();
+	return subTreeHash(this->root);
+}
+
+// ------------------------------------findMismatches-----------------------------------------------
+// Description: walks both trees side by side, only into subtrees whose fingerprints differ, and reports
+// each position where the values differ or one tree has no node. Either pointer given to report may be
+// nullptr. Returns the number of positions reported
+// ---------------------------------------------------------------------------------------------------
+int BinTree::findMismatches(const BinTree & other,
+	const std::function<void(const NodeData* mine, const NodeData* theirs)>& report) const
+{
+	ensureBuilt();
+	other.ensureBuilt();
+	return mismatchHelper(this->root, other.root, report);
+}
+
 
 // utility functions
 
@@ -286,21 +527,21 @@ void BinTree::inorderHelper(Node * root, std::ostream & out) const
 // Helper method for displaySideways
 // Preconditions: NONE
 // Postconditions: BinTree remains unchanged.
-void BinTree::sideways(Node* current, int level) const
+void BinTree::sideways(Node* current, int level, std::ostream& out) const
 {
 	if (current != NULL)
 	{
 		level++;
-		sideways(current->right, level);
+		sideways(current->right, level, out);
 
 		// indent for readability, 4 spaces per depth level 
 		for (int i = level; i >= 0; i--)
 		{
-			cout << "    ";
+			out << "    ";
 		}
 
-		cout << *current->data << endl;        // display information of object
-		sideways(current->left, level);
+		out << *current->data << endl;         // display information of object
+		sideways(current->left, level, out);
 	}
 }
 
@@ -355,6 +596,8 @@ void BinTree::deepCopy(const Node * otherNode, Node * copiedNode)
 		left->data = new NodeData(*otherNode->left->data);
 		left->left = nullptr;
 		left->right = nullptr;
+		left->keyHash = otherNode->left->keyHash;
+		left->hash = otherNode->left->hash;
 		copiedNode->left = left;
 		deepCopy(otherNode->left, copiedNode->left);
 	}
@@ -364,6 +607,8 @@ void BinTree::deepCopy(const Node * otherNode, Node * copiedNode)
 		right->data = new NodeData(*otherNode->right->data);
 		right->left = nullptr;
 		right->right = nullptr;
+		right->keyHash = otherNode->right->keyHash;
+		right->hash = otherNode->right->hash;
 		copiedNode->right = right;
 		deepCopy(otherNode->right, copiedNode->right);
 	}
@@ -408,10 +653,208 @@ void BinTree::toArrayInorderHelper(Node * root, vector<NodeData*> &resultVector)
 // ------------------------------------createBSTFromArray-----------------------------------------------
 // Description: creates balanced binary search tree from array
 // ---------------------------------------------------------------------------------------------------
-void BinTree::createBSTFromArray(vector<NodeData*> vec, int low, int high)
+void BinTree::createBSTFromArray(const vector<NodeData*>& vec, int low, int high)
 {
 	if (low > high) return;
 	this->insert(new NodeData(*vec[(low + high) / 2]));
 	createBSTFromArray(vec, low, (low + high) / 2 - 1);
 	createBSTFromArray(vec, (low + high) / 2 + 1, high);
-}
\ No newline at end of file
+}
+
+// ------------------------------------comparePrefix-----------------------------------------------
+// Description: compares a key against the range of strings starting with prefix, skipping the first lcp
+// bytes which the caller already knows match. Returns -1 if the key sorts before the range, 1 if after,
+// 0 if the key starts with prefix, and updates lcp to the length of the shared prefix
+// ---------------------------------------------------------------------------------------------------
+int BinTree::comparePrefix(const string & prefix, const string & key, size_t & lcp)
+{
+	size_t index = lcp;
+	size_t keyLength = key.size();
+	size_t prefixLength = prefix.size();
+	while (index < prefixLength && index < keyLength && prefix[index] == key[index])
+	{
+		index++;
+	}
+	lcp = index;
+	if (index == prefixLength) return 0;
+	if (index == keyLength) return -1;		// key is a proper prefix of prefix, so it sorts first
+	// std::string orders by unsigned char, match it
+	return ((unsigned char)key[index] < (unsigned char)prefix[index]) ? -1 : 1;
+}
+
+// ------------------------------------prefixWalk-----------------------------------------------
+// Description: bounded in-order walk for findPrefix. lowLcp and highLcp are the shared prefix lengths of
+// the nearest smaller and larger ancestors, every key in between shares at least the smaller of the two
+// ---------------------------------------------------------------------------------------------------
+void BinTree::prefixWalk(const Node * node, const string & prefix, size_t lowLcp, size_t highLcp,
+	const std::function<void(const NodeData&)>& visit, int & count) const
+{
+	while (node != nullptr)
+	{
+		size_t lcp = min(lowLcp, highLcp);
+		int side = comparePrefix(prefix, node->data->getData(), lcp);
+		if (side < 0)
+		{
+			lowLcp = lcp;
+			node = node->right;
+		} else if (side > 0)
+		{
+			highLcp = lcp;
+			node = node->left;
+		} else
+		{
+			prefixWalk(node->left, prefix, lowLcp, lcp, visit, count);
+			visit(*node->data);
+			count++;
+			lowLcp = lcp;
+			node = node->right;
+		}
+	}
+}
+
+// ------------------------------------ensureBuilt-----------------------------------------------
+// Description: builds the pending bulk-loaded data into the tree before a read
+// ---------------------------------------------------------------------------------------------------
+void BinTree::ensureBuilt() const
+{
+	// reads are const to callers, the build only changes how the same contents are stored. Only a tree
+	// that was never const can have pending data, so casting away const here is defined
+	if (!this->pending.empty())
+	{
+		const_cast<BinTree*>(this)->buildPending();
+	}
+}
+
+// ------------------------------------buildPending-----------------------------------------------
+// Description: merges the sorted pending data with the tree contents, drops duplicates and rebuilds
+// a balanced tree reusing the existing NodeData objects
+// ---------------------------------------------------------------------------------------------------
+void BinTree::buildPending()
+{
+	// stable so the earliest insert of equal values is the one kept, values already in the tree win
+	stable_sort(this->pending.begin(), this->pending.end(),
+		[](const NodeData* first, const NodeData* second) { return *first < *second; });
+	vector<NodeData*> existing;
+	existing.reserve(this->size);
+	releaseNodes(this->root, existing);
+	vector<NodeData*> merged;
+	merged.reserve(existing.size() + this->pending.size());
+	merge(existing.begin(), existing.end(), this->pending.begin(), this->pending.end(), back_inserter(merged),
+		[](const NodeData* first, const NodeData* second) { return *first < *second; });
+	this->pending.clear();
+
+	size_t kept = 0;
+	for (NodeData* data : merged)
+	{
+		if (kept > 0 && *merged[kept - 1] == *data)
+		{
+			if (this->duplicateHandler) this->duplicateHandler(*data);
+			delete data;
+			this->bulkDuplicates++;
+		} else
+		{
+			merged[kept] = data;
+			kept++;
+		}
+	}
+	merged.resize(kept);
+	this->root = linkBalanced(merged, 0, (int)kept - 1);
+	this->size = (int)kept;
+}
+
+// ------------------------------------releaseNodes-----------------------------------------------
+// Description: deletes the nodes below the given node but keeps their data, appended in order
+// ---------------------------------------------------------------------------------------------------
+void BinTree::releaseNodes(Node * node, vector<NodeData*>& result)
+{
+	if (node == nullptr) return;
+	releaseNodes(node->left, result);
+	result.push_back(node->data);
+	releaseNodes(node->right, result);
+	delete node;
+}
+
+// ------------------------------------linkBalanced-----------------------------------------------
+// Description: links the sorted data between low and high into a balanced subtree and returns its root
+// ---------------------------------------------------------------------------------------------------
+BinTree::Node* BinTree::linkBalanced(const vector<NodeData*>& sorted, int low, int high)
+{
+	if (low > high) return nullptr;
+	int middle = (low + high) / 2;
+	Node* node = new Node;
+	node->data = sorted[middle];
+	node->left = linkBalanced(sorted, low, middle - 1);
+	node->right = linkBalanced(sorted, middle + 1, high);
+	node->keyHash = hashKey(node->data->getData());
+	rehash(node);
+	return node;
+}
+
+// ------------------------------------logPreorder-----------------------------------------------
+// Description: logs an insert for every node below the given node, parents before children, so replay
+// rebuilds the same shape
+// ---------------------------------------------------------------------------------------------------
+void BinTree::logPreorder(const Node * node)
+{
+	if (node == nullptr) return;
+	this->log->logInsert(*node->data);
+	logPreorder(node->left);
+	logPreorder(node->right);
+}
+
+// ------------------------------------subTreeHash-----------------------------------------------
+// Description: returns the fingerprint of a subtree, a fixed value for an empty one
+// ---------------------------------------------------------------------------------------------------
+uint64_t BinTree::subTreeHash(const Node * node)
+{
+	return (node == nullptr) ? 0x9E3779B97F4A7C15ull : node->hash;
+}
+
+// ------------------------------------mix-----------------------------------------------
+// Description: splitmix64 finalizer, spreads every input bit over the whole result
+// ---------------------------------------------------------------------------------------------------
+static uint64_t mix(uint64_t value)
+{
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+	return value ^ (value >> 31);
+}
+
+// ------------------------------------hashKey-----------------------------------------------
+// Description: hashes a value once when its node is created
+// ---------------------------------------------------------------------------------------------------
+uint64_t BinTree::hashKey(const string & key)
+{
+	// FNV-1a over the key bytes, not std::hash, so fingerprints match between builds and machines
+	uint64_t keyHash = 0xCBF29CE484222325ull;
+	for (char byte : key)
+	{
+		keyHash = (keyHash ^ (unsigned char)byte) * 0x100000001B3ull;
+	}
+	return keyHash;
+}
+
+// ------------------------------------rehash-----------------------------------------------
+// Description: recomputes the fingerprint of a node from its cached value hash and its children's fingerprints
+// ---------------------------------------------------------------------------------------------------
+void BinTree::rehash(Node * node)
+{
+	// left and right are mixed differently so mirrored trees do not collide
+	uint64_t hash = mix(node->keyHash ^ mix(subTreeHash(node->left)));
+	node->hash = mix(hash + 0x632BE59BD9B4E019ull * subTreeHash(node->right));
+}
+
+// ------------------------------------mismatchHelper-----------------------------------------------
+// Description: helper for findMismatches, compares the subtrees at one position of both trees
+// ---------------------------------------------------------------------------------------------------
+int BinTree::mismatchHelper(const Node * mine, const Node * theirs,
+	const std::function<void(const NodeData*, const NodeData*)>& report) const
+{
+	if (subTreeHash(mine) == subTreeHash(theirs)) return 0;
+	if (mine == nullptr || theirs == nullptr || *mine->data != *theirs->data)
+	{
+		report((mine == nullptr) ? nullptr : mine->data, (theirs == nullptr) ? nullptr : theirs->data);
+		return 1;
+	}
+	return mismatchHelper(mine->left, theirs->left, report) + mismatchHelper(mine->right, theirs->right, report);
+}
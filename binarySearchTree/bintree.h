@@ -11,7 +11,12 @@
 #ifndef BINTREE_H
 #define BINTREE_H
 #include "nodedata.h"
+#include "retrievetask.h"
 #include <vector>
+#include <functional>
+#include <cstdint>
+
+class TreeLog;
 
 class BinTree
 {
@@ -54,7 +59,8 @@ public:
 	BinTree& operator=(const BinTree &);
 
 	// ------------------------------------==operator-----------------------------------------------
-	// Description: determines if two binary trees are equivalent
+	// Description: determines if two binary trees are equivalent. Trees with different fingerprints are
+	// rejected in O(1), a full walk only confirms a match
 	// ---------------------------------------------------------------------------------------------------
 	bool operator==(const BinTree &) const;
 
@@ -64,7 +70,8 @@ public:
 	bool operator!=(const BinTree &) const;
 
 	// ------------------------------------insert-----------------------------------------------
-	// Description: inserts data into the binary tree
+	// Description: inserts data into the binary tree. During a bulk load the tree takes ownership of data
+	// and returns true, duplicates are deleted when the tree is built and reported to the duplicate handler
 	// ---------------------------------------------------------------------------------------------------
 	bool insert(NodeData*);
 
@@ -73,6 +80,15 @@ public:
 	// ---------------------------------------------------------------------------------------------------
 	bool retrieve(const NodeData& data, NodeData* & actual) const;
 
+#if defined(__cpp_impl_coroutine)
+	// ------------------------------------asyncRetrieve-----------------------------------------------
+	// Description: retrieve as a coroutine that prefetches and suspends before each memory access down the
+	// tree, see retrievetask.h. data is copied into the task, actual must outlive it and the tree must not
+	// change meanwhile
+	// ---------------------------------------------------------------------------------------------------
+	RetrieveTask asyncRetrieve(NodeData data, NodeData* & actual) const;
+#endif
+
 	// ------------------------------------getHeight-----------------------------------------------
 	// Description:finds height of a given value in the tree
 	// ---------------------------------------------------------------------------------------------------
@@ -83,6 +99,11 @@ public:
 	// ---------------------------------------------------------------------------------------------------
 	void displaySideways() const;			// provided below, displays the tree sideways
 
+	// ------------------------------------displaySideways-----------------------------------------------
+	// Description: displays the tree sideways to the given stream
+	// ---------------------------------------------------------------------------------------------------
+	void displaySideways(std::ostream& out) const;
+
 	// ------------------------------------bstreeToArray-----------------------------------------------
 	// Description: converts binary tree into the given array and resets the binary tree
 	// ---------------------------------------------------------------------------------------------------
@@ -93,6 +114,52 @@ public:
 	// ---------------------------------------------------------------------------------------------------
 	void arrayToBSTree(NodeData*[]);
 
+	// ------------------------------------findPrefix-----------------------------------------------
+	// Description: visits, smallest to largest, every value that starts with the given prefix and returns how
+	// many were visited. Runs in O(height + matches)
+	// ---------------------------------------------------------------------------------------------------
+	int findPrefix(const string& prefix, const std::function<void(const NodeData&)>& visit) const;
+
+	// ------------------------------------longestCommonPrefix-----------------------------------------------
+	// Description: finds the value sharing the longest prefix with the given string, returns the length of
+	// that shared prefix and points actual at the value (nullptr when the tree is empty)
+	// ---------------------------------------------------------------------------------------------------
+	int longestCommonPrefix(const string& query, NodeData* & actual) const;
+
+	// ------------------------------------attachLog-----------------------------------------------
+	// Description: sets the write-ahead log that successful inserts and makeEmpty are recorded to, nullptr
+	// stops logging. Called by TreeLog::open and TreeLog::close
+	// ---------------------------------------------------------------------------------------------------
+	void attachLog(TreeLog*);
+
+	// ------------------------------------beginBulkLoad-----------------------------------------------
+	// Description: starts deferred building, insert appends to an unsorted buffer in O(1) and the next
+	// read sorts the buffer, drops duplicates and rebuilds a balanced tree in one pass. onDuplicate, if
+	// given, sees each duplicate before it is deleted. The reads that build are const but change the tree
+	// and run onDuplicate, so while data is pending they must not run on several threads at once. A tree
+	// declared const never has pending data, its copy constructor builds the source first
+	// ---------------------------------------------------------------------------------------------------
+	void beginBulkLoad(const std::function<void(const NodeData&)>& onDuplicate = nullptr);
+
+	// ------------------------------------endBulkLoad-----------------------------------------------
+	// Description: builds anything still buffered, returns to normal inserts and returns how many
+	// duplicates were dropped since beginBulkLoad
+	// ---------------------------------------------------------------------------------------------------
+	int endBulkLoad();
+
+	// ------------------------------------fingerprint-----------------------------------------------
+	// Description: returns a hash of every value and the shape of the tree, equal trees have equal
+	// fingerprints on every platform
+	// ---------------------------------------------------------------------------------------------------
+	uint64_t fingerprint() const;
+
+	// ------------------------------------findMismatches-----------------------------------------------
+	// Description: walks both trees side by side, only into subtrees whose fingerprints differ, and reports
+	// each position where the values differ or one tree has no node. Either pointer given to report may be
+	// nullptr. Returns the number of positions reported
+	// ---------------------------------------------------------------------------------------------------
+	int findMismatches(const BinTree& other,
+		const std::function<void(const NodeData* mine, const NodeData* theirs)>& report) const;
 
 private:
 
@@ -101,10 +168,18 @@ private:
 		NodeData* data;						// pointer to data object
 		Node* left;							// left subtree pointer
 		Node* right;						// right subtree pointer
+		uint64_t keyHash;					// hash of the value alone, computed once
+		uint64_t hash;						// fingerprint of the value and both subtrees
 	};
 
 	Node* root;								// root of the tree
 	int size;								// number of nodes in the tree
+	TreeLog* log;							// write-ahead log, nullptr when not logging
+	bool bulkLoading;						// true between beginBulkLoad and endBulkLoad
+	vector<NodeData*> pending;				// bulk-loaded data not yet in the tree, unsorted
+	std::function<void(const NodeData&)> duplicateHandler;	// reports duplicates found while building
+	int bulkDuplicates;						// duplicates dropped since beginBulkLoad
+	vector<Node*> insertPath;				// nodes passed by the last insert, reused so insert does not allocate
 
 // utility functions
 
@@ -116,7 +191,7 @@ private:
 	// ------------------------------------sideways-----------------------------------------------
 	// Description: helper for display sideways
 	// ---------------------------------------------------------------------------------------------------
-	void sideways(Node*, int) const;			// provided below, helper for displaySideways()
+	void sideways(Node*, int, std::ostream&) const;	// provided below, helper for displaySideways()
 
 	// ------------------------------------deleteSubTree-----------------------------------------------
 	// Description: deletes the given node and nodeData and all the information below it
@@ -146,7 +221,69 @@ private:
 	// ------------------------------------createBSTFromArray-----------------------------------------------
 	// Description: creates balanced binary search tree from array
 	// ---------------------------------------------------------------------------------------------------
-	void createBSTFromArray(vector<NodeData*>, int, int);
+	void createBSTFromArray(const vector<NodeData*>&, int, int);
+
+	// ------------------------------------ensureBuilt-----------------------------------------------
+	// Description: builds the pending bulk-loaded data into the tree before a read
+	// ---------------------------------------------------------------------------------------------------
+	void ensureBuilt() const;
+
+	// ------------------------------------buildPending-----------------------------------------------
+	// Description: merges the sorted pending data with the tree contents, drops duplicates and rebuilds
+	// a balanced tree reusing the existing NodeData objects
+	// ---------------------------------------------------------------------------------------------------
+	void buildPending();
+
+	// ------------------------------------releaseNodes-----------------------------------------------
+	// Description: deletes the nodes below the given node but keeps their data, appended in order
+	// ---------------------------------------------------------------------------------------------------
+	void releaseNodes(Node*, vector<NodeData*>&);
+
+	// ------------------------------------linkBalanced-----------------------------------------------
+	// Description: links the sorted data between low and high into a balanced subtree and returns its root
+	// ---------------------------------------------------------------------------------------------------
+	Node* linkBalanced(const vector<NodeData*>&, int low, int high);
+
+	// ------------------------------------logPreorder-----------------------------------------------
+	// Description: logs an insert for every node below the given node, parents before children, so replay
+	// rebuilds the same shape
+	// ---------------------------------------------------------------------------------------------------
+	void logPreorder(const Node*);
+
+	// ------------------------------------subTreeHash-----------------------------------------------
+	// Description: returns the fingerprint of a subtree, a fixed value for an empty one
+	// ---------------------------------------------------------------------------------------------------
+	static uint64_t subTreeHash(const Node*);
+
+	// ------------------------------------hashKey-----------------------------------------------
+	// Description: hashes a value once when its node is created
+	// ---------------------------------------------------------------------------------------------------
+	static uint64_t hashKey(const string&);
+
+	// ------------------------------------rehash-----------------------------------------------
+	// Description: recomputes the fingerprint of a node from its cached value hash and its children's fingerprints
+	// ---------------------------------------------------------------------------------------------------
+	static void rehash(Node*);
+
+	// ------------------------------------mismatchHelper-----------------------------------------------
+	// Description: helper for findMismatches, compares the subtrees at one position of both trees
+	// ---------------------------------------------------------------------------------------------------
+	int mismatchHelper(const Node*, const Node*,
+		const std::function<void(const NodeData*, const NodeData*)>&) const;
+
+	// ------------------------------------comparePrefix-----------------------------------------------
+	// Description: compares a key against the range of strings starting with prefix, skipping the first lcp
+	// bytes which the caller already knows match. Returns -1 if the key sorts before the range, 1 if after,
+	// 0 if the key starts with prefix, and updates lcp to the length of the shared prefix
+	// ---------------------------------------------------------------------------------------------------
+	static int comparePrefix(const string& prefix, const string& key, size_t& lcp);
+
+	// ------------------------------------prefixWalk-----------------------------------------------
+	// Description: bounded in-order walk for findPrefix. lowLcp and highLcp are the shared prefix lengths of
+	// the nearest smaller and larger ancestors, every key in between shares at least the smaller of the two
+	// ---------------------------------------------------------------------------------------------------
+	void prefixWalk(const Node*, const string&, size_t lowLcp, size_t highLcp,
+		const std::function<void(const NodeData&)>&, int&) const;
 
 };
 #endif
\ No newline at end of file
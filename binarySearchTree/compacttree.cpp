@@ -0,0 +1,214 @@
+// ------------------------------------------------ compacttree.cpp -------------------------------------------------------
+// Creation Date: 10/19/2026
+// --------------------------------------------------------------------------------------------------------------------
+// Purpose - Data structure implementation of a memory compact binary search tree of strings
+// --------------------------------------------------------------------------------------------------------------------
+// Nodes are only ever appended, so an index stays valid for the life of the tree.  Keys compare byte by byte as
+// unsigned chars, the same order std::string and NodeData use.
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "compacttree.h"
+#include <algorithm>
+#include <cstring>
+
+// ------------------------------------<<-----------------------------------------------
+// Description: Prints tree contents in-order from smallest to largest
+// ---------------------------------------------------------------------------------------------------
+std::ostream & operator<<(std::ostream & out, const CompactBinTree & tree)
+{
+	if (!tree.isEmpty())
+	{
+		tree.inorderHelper(0, out);
+	}
+	out << std::endl;
+	return out;
+}
+
+// ------------------------------------CompactBinTree-----------------------------------------------
+// Description: constructor for compact binary tree
+// ---------------------------------------------------------------------------------------------------
+CompactBinTree::CompactBinTree()
+{
+}
+
+// ------------------------------------isEmpty-----------------------------------------------
+// Description: returns if tree is empty
+// ---------------------------------------------------------------------------------------------------
+bool CompactBinTree::isEmpty() const
+{
+	return this->nodes.empty();
+}
+
+// ------------------------------------makeEmpty-----------------------------------------------
+// Description: empties tree and releases its memory
+// ---------------------------------------------------------------------------------------------------
+void CompactBinTree::makeEmpty()
+{
+	vector<Node>().swap(this->nodes);
+	vector<char>().swap(this->longKeys);
+}
+
+// ------------------------------------reserve-----------------------------------------------
+// Description: preallocates room for the given number of keys
+// ---------------------------------------------------------------------------------------------------
+void CompactBinTree::reserve(size_t keys)
+{
+	this->nodes.reserve(keys);
+}
+
+// ------------------------------------insert-----------------------------------------------
+// Description: copies the key into the tree, returns false for a duplicate or when the tree is full
+// ---------------------------------------------------------------------------------------------------
+bool CompactBinTree::insert(const NodeData & data)
+{
+	const string& key = data.getData();
+	if (this->nodes.size() >= NO_NODE) return false;
+	if (key.size() > INLINE_CAPACITY && key.size() > 0xFFFFFFFFu - this->longKeys.size()) return false;
+
+	uint32_t* link = nullptr;				// child slot the new node goes in, none for the root
+	if (!this->nodes.empty())
+	{
+		uint32_t current = 0;
+		while (current != NO_NODE)
+		{
+			int order = compareKey(key, this->nodes[current]);
+			if (order == 0) return false;
+			link = (order < 0) ? &this->nodes[current].left : &this->nodes[current].right;
+			current = *link;
+		}
+	}
+
+	Node node;
+	node.left = NO_NODE;
+	node.right = NO_NODE;
+	memset(node.key, 0, sizeof(node.key));
+	if (key.size() <= INLINE_CAPACITY)
+	{
+		node.length = (unsigned char)key.size();
+		memcpy(node.key, key.data(), key.size());
+	} else
+	{
+		uint32_t offset = (uint32_t)this->longKeys.size();
+		uint32_t length = (uint32_t)key.size();
+		node.length = LONG_KEY;
+		memcpy(node.key + 3, &offset, sizeof(offset));
+		memcpy(node.key + 7, &length, sizeof(length));
+		this->longKeys.insert(this->longKeys.end(), key.begin(), key.end());
+	}
+
+	// set the link before push_back, which may move the array link points into
+	uint32_t index = (uint32_t)this->nodes.size();
+	if (link != nullptr)
+	{
+		*link = index;
+	}
+	this->nodes.push_back(node);
+	return true;
+}
+
+// ------------------------------------retrieve-----------------------------------------------
+// Description: reports if the key is in the tree
+// ---------------------------------------------------------------------------------------------------
+bool CompactBinTree::retrieve(const NodeData & data) const
+{
+	return find(data.getData()) != NO_NODE;
+}
+
+// ------------------------------------getHeight-----------------------------------------------
+// Description: finds height of a given value in the tree, 0 if it is not found
+// ---------------------------------------------------------------------------------------------------
+int CompactBinTree::getHeight(const NodeData & data) const
+{
+	return getNodeHeight(find(data.getData()));
+}
+
+// ------------------------------------getSize-----------------------------------------------
+// Description: returns the number of keys in the tree
+// ---------------------------------------------------------------------------------------------------
+size_t CompactBinTree::getSize() const
+{
+	return this->nodes.size();
+}
+
+// ------------------------------------bytesUsed-----------------------------------------------
+// Description: returns the bytes allocated for nodes and long keys
+// ---------------------------------------------------------------------------------------------------
+size_t CompactBinTree::bytesUsed() const
+{
+	return this->nodes.capacity() * sizeof(Node) + this->longKeys.capacity();
+}
+
+
+// utility functions
+
+// ------------------------------------keyOf-----------------------------------------------
+// Description: finds the bytes and length of the key held by a node
+// ---------------------------------------------------------------------------------------------------
+void CompactBinTree::keyOf(const Node & node, const char* & bytes, size_t & length) const
+{
+	if (node.length != LONG_KEY)
+	{
+		bytes = node.key;
+		length = node.length;
+		return;
+	}
+	uint32_t offset;
+	uint32_t longLength;
+	memcpy(&offset, node.key + 3, sizeof(offset));
+	memcpy(&longLength, node.key + 7, sizeof(longLength));
+	bytes = this->longKeys.data() + offset;
+	length = longLength;
+}
+
+// ------------------------------------compareKey-----------------------------------------------
+// Description: compares a string with the key of a node, negative, zero or positive like string::compare
+// ---------------------------------------------------------------------------------------------------
+int CompactBinTree::compareKey(const string & key, const Node & node) const
+{
+	const char* bytes;
+	size_t length;
+	keyOf(node, bytes, length);
+	int order = memcmp(key.data(), bytes, min(key.size(), length));
+	if (order != 0) return order;
+	if (key.size() == length) return 0;
+	return (key.size() < length) ? -1 : 1;
+}
+
+// ------------------------------------find-----------------------------------------------
+// Description: returns the index of the node holding the key, NO_NODE if not found
+// ---------------------------------------------------------------------------------------------------
+uint32_t CompactBinTree::find(const string & key) const
+{
+	uint32_t current = this->nodes.empty() ? NO_NODE : 0;
+	while (current != NO_NODE)
+	{
+		int order = compareKey(key, this->nodes[current]);
+		if (order == 0) return current;
+		current = (order < 0) ? this->nodes[current].left : this->nodes[current].right;
+	}
+	return NO_NODE;
+}
+
+// ------------------------------------getNodeHeight-----------------------------------------------
+// Description: gets height of the node at the given index
+// ---------------------------------------------------------------------------------------------------
+int CompactBinTree::getNodeHeight(uint32_t index) const
+{
+	if (index == NO_NODE) return 0;
+	return max(getNodeHeight(this->nodes[index].left), getNodeHeight(this->nodes[index].right)) + 1;
+}
+
+// ------------------------------------inorderHelper-----------------------------------------------
+// Description: inorder helper for << overload
+// ---------------------------------------------------------------------------------------------------
+void CompactBinTree::inorderHelper(uint32_t index, std::ostream & out) const
+{
+	if (index == NO_NODE) return;
+	inorderHelper(this->nodes[index].left, out);
+	const char* bytes;
+	size_t length;
+	keyOf(this->nodes[index], bytes, length);
+	out.write(bytes, length);
+	out << " ";
+	inorderHelper(this->nodes[index].right, out);
+}
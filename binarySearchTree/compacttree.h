@@ -0,0 +1,117 @@
+// ------------------------------------------------ compacttree.h -------------------------------------------------------
+// Creation Date: 10/19/2026
+// --------------------------------------------------------------------------------------------------------------------
+// Purpose - Data structure declaration of a memory compact binary search tree of strings
+// --------------------------------------------------------------------------------------------------------------------
+// Holds the same string keys as BinTree in far less memory.  Nodes live in one array and refer to their children
+// by 32-bit index instead of by pointer, and keys of up to 11 bytes are stored inside the node, so a short key
+// costs one 20 byte node and no heap allocation of its own.  Longer keys are copied into one shared character
+// array.  The tree copies keys on insert, it does not take ownership of NodeData objects.
+// --------------------------------------------------------------------------------------------------------------------
+#ifndef COMPACTTREE_H
+#define COMPACTTREE_H
+#include "nodedata.h"
+#include <cstdint>
+#include <vector>
+
+class CompactBinTree
+{
+
+	// ------------------------------------<<-----------------------------------------------
+	// Description: Prints tree contents in-order from smallest to largest
+	// ---------------------------------------------------------------------------------------------------
+	friend std::ostream& operator<<(std::ostream &out, const CompactBinTree& tree);
+
+public:
+
+	// ------------------------------------CompactBinTree-----------------------------------------------
+	// Description: constructor for compact binary tree
+	// ---------------------------------------------------------------------------------------------------
+	CompactBinTree();
+
+	// ------------------------------------isEmpty-----------------------------------------------
+	// Description: returns if tree is empty
+	// ---------------------------------------------------------------------------------------------------
+	bool isEmpty() const;
+
+	// ------------------------------------makeEmpty-----------------------------------------------
+	// Description: empties tree and releases its memory
+	// ---------------------------------------------------------------------------------------------------
+	void makeEmpty();
+
+	// ------------------------------------reserve-----------------------------------------------
+	// Description: preallocates room for the given number of keys
+	// ---------------------------------------------------------------------------------------------------
+	void reserve(size_t keys);
+
+	// ------------------------------------insert-----------------------------------------------
+	// Description: copies the key into the tree, returns false for a duplicate or when the tree is full
+	// ---------------------------------------------------------------------------------------------------
+	bool insert(const NodeData&);
+
+	// ------------------------------------retrieve-----------------------------------------------
+	// Description: reports if the key is in the tree
+	// ---------------------------------------------------------------------------------------------------
+	bool retrieve(const NodeData&) const;
+
+	// ------------------------------------getHeight-----------------------------------------------
+	// Description: finds height of a given value in the tree, 0 if it is not found
+	// ---------------------------------------------------------------------------------------------------
+	int getHeight(const NodeData&) const;
+
+	// ------------------------------------getSize-----------------------------------------------
+	// Description: returns the number of keys in the tree
+	// ---------------------------------------------------------------------------------------------------
+	size_t getSize() const;
+
+	// ------------------------------------bytesUsed-----------------------------------------------
+	// Description: returns the bytes allocated for nodes and long keys
+	// ---------------------------------------------------------------------------------------------------
+	size_t bytesUsed() const;
+
+private:
+
+	static const uint32_t NO_NODE = 0xFFFFFFFF;		// child index meaning no child
+	static const int INLINE_CAPACITY = 11;				// longest key stored inside the node
+	static const unsigned char LONG_KEY = 0xFF;			// length marker for a key kept in longKeys
+
+	struct Node
+	{
+		uint32_t left;						// index of left subtree, NO_NODE if none
+		uint32_t right;						// index of right subtree, NO_NODE if none
+		unsigned char length;				// key length, or LONG_KEY
+		char key[INLINE_CAPACITY];			// key bytes, or for a long key its offset and length in longKeys
+	};
+
+	vector<Node> nodes;						// all nodes, the root is nodes[0]
+	vector<char> longKeys;					// bytes of keys longer than INLINE_CAPACITY
+
+// utility functions
+
+	// ------------------------------------keyOf-----------------------------------------------
+	// Description: finds the bytes and length of the key held by a node
+	// ---------------------------------------------------------------------------------------------------
+	void keyOf(const Node&, const char* & bytes, size_t & length) const;
+
+	// ------------------------------------compareKey-----------------------------------------------
+	// Description: compares a string with the key of a node, negative, zero or positive like string::compare
+	// ---------------------------------------------------------------------------------------------------
+	int compareKey(const string&, const Node&) const;
+
+	// ------------------------------------find-----------------------------------------------
+	// Description: returns the index of the node holding the key, NO_NODE if not found
+	// ---------------------------------------------------------------------------------------------------
+	uint32_t find(const string&) const;
+
+	// ------------------------------------getNodeHeight-----------------------------------------------
+	// Description: gets height of the node at the given index
+	// ---------------------------------------------------------------------------------------------------
+	int getNodeHeight(uint32_t) const;
+
+	// ------------------------------------inorderHelper-----------------------------------------------
+	// Description: inorder helper for << overload
+	// ---------------------------------------------------------------------------------------------------
+	void inorderHelper(uint32_t, std::ostream&) const;
+
+};
+#endif
@@ -13,6 +13,9 @@
 #include "bintree.h"
 #include <fstream>
 #include <iostream>
+#ifdef _MSC_VER
+#include <crtdbg.h>
+#endif
 using namespace std;
 
 const int ARRAYSIZE = 100;
@@ -95,7 +98,9 @@ int main()
 		buildTree(T, infile);
 		cout << endl;
 	}
+#ifdef _MSC_VER
 	_CrtDumpMemoryLeaks();
+#endif
 	return 0;
 }
 
@@ -60,6 +60,14 @@ bool NodeData::setData(istream& infile)
 	return !infile.eof();       // eof function is true when eof char is read
 }
 
+//------------------------------ getData -------------------------------------
+// returns the key string without copying it
+
+const string& NodeData::getData() const
+{
+	return data;
+}
+
 //-------------------------- operator<< --------------------------------------
 ostream& operator<<(ostream& output, const NodeData& nd)
 {
@@ -23,6 +23,8 @@ public:
 	// returns true if the data is set, false when bad data, i.e., is eof
 	bool setData(istream&);
 
+	const string& getData() const;   // read-only access to the key string
+
 	bool operator==(const NodeData &) const;
 	bool operator!=(const NodeData &) const;
 	bool operator<(const NodeData &) const;
@@ -0,0 +1,166 @@
+// ------------------------------------------------ retrievetask.cpp -------------------------------------------------------
+// Creation Date: 10/19/2026
+// --------------------------------------------------------------------------------------------------------------------
+// Purpose - Coroutine lookups that can be interleaved with each other and with other work
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "retrievetask.h"
+#if defined(__cpp_impl_coroutine)
+#include <algorithm>
+#include <utility>
+
+// ------------------------------------RetrieveTask-----------------------------------------------
+// Description: constructor for an empty task that owns no lookup and is already done
+// ---------------------------------------------------------------------------------------------------
+RetrieveTask::RetrieveTask()
+{
+	this->handle = nullptr;
+}
+
+// ------------------------------------RetrieveTask-----------------------------------------------
+// Description: wraps a lookup created by BinTree::asyncRetrieve
+// ---------------------------------------------------------------------------------------------------
+RetrieveTask::RetrieveTask(std::coroutine_handle<promise_type> handle)
+{
+	this->handle = handle;
+}
+
+// ------------------------------------RetrieveTask-----------------------------------------------
+// Description: move constructor, the moved from task no longer owns the lookup
+// ---------------------------------------------------------------------------------------------------
+RetrieveTask::RetrieveTask(RetrieveTask && other) noexcept
+{
+	this->handle = std::exchange(other.handle, nullptr);
+}
+
+// ------------------------------------=operator-----------------------------------------------
+// Description: move assignment, destroys the lookup this task owned
+// ---------------------------------------------------------------------------------------------------
+RetrieveTask & RetrieveTask::operator=(RetrieveTask && other) noexcept
+{
+	if (this != &other)
+	{
+		if (this->handle) this->handle.destroy();
+		this->handle = std::exchange(other.handle, nullptr);
+	}
+	return *this;
+}
+
+// ------------------------------------~RetrieveTask-----------------------------------------------
+// Description: destroys the lookup, finished or not
+// ---------------------------------------------------------------------------------------------------
+RetrieveTask::~RetrieveTask()
+{
+	if (this->handle) this->handle.destroy();
+}
+
+// ------------------------------------done-----------------------------------------------
+// Description: true once the lookup has finished
+// ---------------------------------------------------------------------------------------------------
+bool RetrieveTask::done() const
+{
+	return !this->handle || this->handle.done();
+}
+
+// ------------------------------------resume-----------------------------------------------
+// Description: runs the lookup to its next suspension, does nothing once it is done
+// ---------------------------------------------------------------------------------------------------
+void RetrieveTask::resume()
+{
+	if (!done()) this->handle.resume();
+}
+
+// ------------------------------------result-----------------------------------------------
+// Description: runs the lookup to the end if needed and returns if the value was found
+// ---------------------------------------------------------------------------------------------------
+bool RetrieveTask::result()
+{
+	while (!done())
+	{
+		this->handle.resume();
+	}
+	return this->handle && this->handle.promise().found;
+}
+
+// ------------------------------------add-----------------------------------------------
+// Description: takes a lookup to run and returns the id result is later called with, ids of collected
+// lookups are reused
+// ---------------------------------------------------------------------------------------------------
+int LookupScheduler::add(RetrieveTask && task)
+{
+	int id;
+	if (this->freeIds.empty())
+	{
+		id = (int)this->tasks.size();
+		this->tasks.push_back(std::move(task));
+	} else
+	{
+		id = this->freeIds.back();
+		this->freeIds.pop_back();
+		this->tasks[id] = std::move(task);
+	}
+	if (!this->tasks[id].done())
+	{
+		this->active.push_back(id);
+	}
+	return id;
+}
+
+// ------------------------------------step-----------------------------------------------
+// Description: resumes every unfinished lookup once, returns true while any remain unfinished
+// ---------------------------------------------------------------------------------------------------
+bool LookupScheduler::step()
+{
+	size_t kept = 0;
+	for (int id : this->active)
+	{
+		this->tasks[id].resume();
+		if (!this->tasks[id].done())
+		{
+			this->active[kept] = id;
+			kept++;
+		}
+	}
+	this->active.resize(kept);
+	return kept > 0;
+}
+
+// ------------------------------------run-----------------------------------------------
+// Description: steps until every lookup has finished
+// ---------------------------------------------------------------------------------------------------
+void LookupScheduler::run()
+{
+	while (step())
+	{
+	}
+}
+
+// ------------------------------------result-----------------------------------------------
+// Description: returns if the lookup with the given id found its value, finishing it first if needed,
+// then destroys the lookup and frees the id. Call once per id
+// ---------------------------------------------------------------------------------------------------
+bool LookupScheduler::result(int id)
+{
+	// finished here rather than by step, so step must not see the id again once it is reused
+	std::vector<int>::iterator position = std::find(this->active.begin(), this->active.end(), id);
+	if (position != this->active.end())
+	{
+		this->active.erase(position);
+	}
+	bool found = this->tasks[id].result();
+	this->tasks[id] = RetrieveTask();
+	this->freeIds.push_back(id);
+	return found;
+}
+
+// ------------------------------------clear-----------------------------------------------
+// Description: destroys every lookup, finished or not
+// ---------------------------------------------------------------------------------------------------
+void LookupScheduler::clear()
+{
+	this->tasks.clear();
+	this->active.clear();
+	this->freeIds.clear();
+}
+
+#endif
@@ -0,0 +1,121 @@
+// ------------------------------------------------ retrievetask.h -------------------------------------------------------
+// Creation Date: 10/19/2026
+// --------------------------------------------------------------------------------------------------------------------
+// Purpose - Coroutine lookups that can be interleaved with each other and with other work
+// --------------------------------------------------------------------------------------------------------------------
+// BinTree::asyncRetrieve returns a RetrieveTask.  The lookup starts suspended and, each time it is resumed, moves
+// one step down the tree: it prefetches the memory the next step reads and suspends again instead of waiting on
+// the cache miss.  Resuming many lookups in turn overlaps their misses.  LookupScheduler does that round robin,
+// step resumes every unfinished lookup once so an event loop can call it between polls, run finishes them all.
+// Collecting a lookup's result frees its slot, so a long running loop only holds the lookups still in use.
+//
+// Needs C++20 coroutines, without them this header declares nothing.
+// --------------------------------------------------------------------------------------------------------------------
+#ifndef RETRIEVETASK_H
+#define RETRIEVETASK_H
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#include <exception>
+#include <vector>
+
+class RetrieveTask
+{
+public:
+
+	struct promise_type
+	{
+		bool found = false;					// value of co_return
+
+		RetrieveTask get_return_object() { return RetrieveTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		void return_value(bool value) { found = value; }
+		void unhandled_exception() { std::terminate(); }
+	};
+
+	// ------------------------------------RetrieveTask-----------------------------------------------
+	// Description: constructor for an empty task that owns no lookup and is already done
+	// ---------------------------------------------------------------------------------------------------
+	RetrieveTask();
+
+	// ------------------------------------RetrieveTask-----------------------------------------------
+	// Description: move constructor, the moved from task no longer owns the lookup
+	// ---------------------------------------------------------------------------------------------------
+	RetrieveTask(RetrieveTask&&) noexcept;
+
+	// ------------------------------------=operator-----------------------------------------------
+	// Description: move assignment, destroys the lookup this task owned
+	// ---------------------------------------------------------------------------------------------------
+	RetrieveTask& operator=(RetrieveTask&&) noexcept;
+
+	// ------------------------------------~RetrieveTask-----------------------------------------------
+	// Description: destroys the lookup, finished or not
+	// ---------------------------------------------------------------------------------------------------
+	~RetrieveTask();
+
+	// ------------------------------------done-----------------------------------------------
+	// Description: true once the lookup has finished
+	// ---------------------------------------------------------------------------------------------------
+	bool done() const;
+
+	// ------------------------------------resume-----------------------------------------------
+	// Description: runs the lookup to its next suspension, does nothing once it is done
+	// ---------------------------------------------------------------------------------------------------
+	void resume();
+
+	// ------------------------------------result-----------------------------------------------
+	// Description: runs the lookup to the end if needed and returns if the value was found
+	// ---------------------------------------------------------------------------------------------------
+	bool result();
+
+private:
+
+	explicit RetrieveTask(std::coroutine_handle<promise_type>);
+	RetrieveTask(const RetrieveTask&) = delete;
+	RetrieveTask& operator=(const RetrieveTask&) = delete;
+
+	std::coroutine_handle<promise_type> handle;		// the suspended lookup, empty after a move
+
+};
+
+class LookupScheduler
+{
+public:
+
+	// ------------------------------------add-----------------------------------------------
+	// Description: takes a lookup to run and returns the id result is later called with, ids of collected
+	// lookups are reused
+	// ---------------------------------------------------------------------------------------------------
+	int add(RetrieveTask&&);
+
+	// ------------------------------------step-----------------------------------------------
+	// Description: resumes every unfinished lookup once, returns true while any remain unfinished
+	// ---------------------------------------------------------------------------------------------------
+	bool step();
+
+	// ------------------------------------run-----------------------------------------------
+	// Description: steps until every lookup has finished
+	// ---------------------------------------------------------------------------------------------------
+	void run();
+
+	// ------------------------------------result-----------------------------------------------
+	// Description: returns if the lookup with the given id found its value, finishing it first if needed,
+	// then destroys the lookup and frees the id. Call once per id
+	// ---------------------------------------------------------------------------------------------------
+	bool result(int id);
+
+	// ------------------------------------clear-----------------------------------------------
+	// Description: destroys every lookup, finished or not
+	// ---------------------------------------------------------------------------------------------------
+	void clear();
+
+private:
+
+	std::vector<RetrieveTask> tasks;		// lookups indexed by id, empty once their result is collected
+	std::vector<int> active;				// ids of lookups not yet finished
+	std::vector<int> freeIds;				// ids whose result was collected, reused by add
+
+};
+
+#endif
+#endif
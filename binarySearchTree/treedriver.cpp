@@ -0,0 +1,288 @@
+// ------------------------------------------------ treedriver.cpp -------------------------------------------------------
+// Creation Date: 10/19/2026
+// --------------------------------------------------------------------------------------------------------------------
+// Purpose - Parallel driver that runs the lab2 checks over many trees at once
+// --------------------------------------------------------------------------------------------------------------------
+// Reads a data file in the lab2 format, where every record is a run of strings ending with "$$", and runs the same
+// checks lab2 does on each record: build, copy, compare, retrieve, getHeight and the array round trip.  As in lab2
+// each tree is compared with the trees of the first and the previous record, which a worker rebuilds from those
+// records' strings, so records stay independent and worker threads read them one at a time from the shared file.
+// Each record's output goes to its own string buffer, and the main thread prints finished records in file order
+// while the workers run, so threads never contend for cout.  Workers stay at most a window of records ahead of the
+// printer, which bounds memory no matter how large the file is.  Timing goes to cerr, throughput per core uses
+// each thread's CPU time.
+//
+// usage: treedriver [data file] [threads] [-q]
+//   data file  defaults to data2.txt
+//   threads    defaults to the number of hardware threads
+//   -q         skip printing the per-record output, only report timing
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "bintree.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+const unsigned RECORDS_PER_THREAD_AHEAD = 4;	// window of unprinted records each worker thread adds
+
+// state shared by the workers and the printer, guarded by lock
+struct DriverState
+{
+	ifstream infile;						// data file, read by whichever worker holds lock
+	mutex lock;
+	condition_variable changed;				// signals a record was read, finished or printed
+	size_t nextRead = 0;					// index of the next record to read
+	size_t nextPrint = 0;					// index of the next record to print
+	shared_ptr<const vector<string>> firstRecord;		// strings of record 0, lab2's first tree
+	shared_ptr<const vector<string>> previousRecord;	// strings of the last record read, lab2's dup tree
+	bool inputDone = false;					// the end of the file has been reached
+	vector<string> slots;					// output of record i is in slots[i % window]
+	vector<char> ready;						// ready[i % window] is set once record i has finished
+};
+
+//global function prototypes
+bool readRecord(istream&, vector<string>&);
+void buildTree(BinTree&, const vector<string>&);
+void runRecord(const vector<string>&, const vector<string>&, const vector<string>&, ostream&);
+void worker(DriverState&, double&);
+double threadCpuSeconds();
+
+int main(int argc, char* argv[])
+{
+	string fileName = "data2.txt";
+	unsigned threadCount = thread::hardware_concurrency();
+	bool quiet = false;
+	int positional = 0;
+	for (int i = 1; i < argc; i++)
+	{
+		string argument = argv[i];
+		if (argument == "-q")
+		{
+			quiet = true;
+		} else if (positional == 0)
+		{
+			fileName = argument;
+			positional++;
+		} else
+		{
+			threadCount = (unsigned)atoi(argv[i]);
+			positional++;
+		}
+	}
+	if (threadCount == 0) threadCount = 1;
+
+	DriverState state;
+	state.infile.open(fileName);
+	if (!state.infile)
+	{
+		cout << "File could not be opened." << endl;
+		return 1;
+	}
+	size_t window = (size_t)threadCount * RECORDS_PER_THREAD_AHEAD;
+	state.slots.resize(window);
+	state.ready.resize(window, 0);
+
+	vector<double> cpuSeconds(threadCount, 0.0);
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	vector<thread> workers;
+	for (unsigned t = 0; t < threadCount; t++)
+	{
+		workers.emplace_back(worker, ref(state), ref(cpuSeconds[t]));
+	}
+
+	// print finished records in file order as soon as each one's predecessors are printed
+	unique_lock<mutex> guard(state.lock);
+	while (true)
+	{
+		state.changed.wait(guard, [&state, window]
+		{
+			return state.ready[state.nextPrint % window] || (state.inputDone && state.nextPrint == state.nextRead);
+		});
+		size_t slot = state.nextPrint % window;
+		if (!state.ready[slot]) break;
+		string text = move(state.slots[slot]);
+		state.slots[slot].clear();
+		state.ready[slot] = 0;
+		state.nextPrint++;
+		guard.unlock();
+		state.changed.notify_all();			// a worker may be waiting for room in the window
+		if (!quiet)
+		{
+			cout << text;
+		}
+		guard.lock();
+	}
+	size_t recordCount = state.nextRead;
+	guard.unlock();
+	for (thread& running : workers)
+	{
+		running.join();
+	}
+	cout.flush();
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	double cpuTotal = 0.0;
+	for (double cpu : cpuSeconds)
+	{
+		cpuTotal += cpu;
+	}
+	cerr << recordCount << " records, " << threadCount << " threads, " << seconds << " s, "
+		<< cpuTotal << " s worker CPU" << endl;
+	if (seconds > 0.0 && cpuTotal > 0.0)
+	{
+		cerr << "  " << recordCount / seconds << " records/s, "
+			<< recordCount / cpuTotal << " records per CPU second" << endl;
+	}
+	return 0;
+}
+
+//------------------------------- readRecord ----------------------------------
+// Reads the next record, which ends at "$$" or at the end of the file. Returns false when there is none
+bool readRecord(istream& infile, vector<string>& record)
+{
+	string s;
+	while (infile >> s)
+	{
+		if (s == "$$") return true;
+		record.push_back(s);
+	}
+	return !record.empty();
+}
+
+//------------------------------- worker ----------------------------------
+// Reads and runs records until the file is done, then stores the CPU time this thread used
+void worker(DriverState& state, double& cpuSeconds)
+{
+	size_t window = state.slots.size();
+	ostringstream buffer;
+	while (true)
+	{
+		size_t index;
+		vector<string> record;
+		shared_ptr<const vector<string>> current;
+		shared_ptr<const vector<string>> first;
+		shared_ptr<const vector<string>> previous;
+		{
+			unique_lock<mutex> guard(state.lock);
+			state.changed.wait(guard, [&state, window]
+			{
+				return state.inputDone || state.nextRead < state.nextPrint + window;
+			});
+			if (state.inputDone) break;
+			if (!readRecord(state.infile, record))
+			{
+				state.inputDone = true;
+				state.changed.notify_all();
+				break;
+			}
+			index = state.nextRead;
+			state.nextRead++;
+			current = make_shared<vector<string>>(move(record));
+			if (index == 0) state.firstRecord = current;
+			first = state.firstRecord;
+			previous = (index == 0) ? current : state.previousRecord;
+			state.previousRecord = current;
+		}
+
+		buffer.str("");
+		runRecord(*current, *first, *previous, buffer);
+		{
+			lock_guard<mutex> guard(state.lock);
+			state.slots[index % window] = buffer.str();
+			state.ready[index % window] = 1;
+		}
+		state.changed.notify_all();
+	}
+	cpuSeconds = threadCpuSeconds();
+}
+
+//------------------------------- threadCpuSeconds ----------------------------------
+// Returns the CPU time used so far by the calling thread, 0 where it cannot be read
+double threadCpuSeconds()
+{
+#ifdef _WIN32
+	FILETIME created, exited, kernel, user;
+	if (!GetThreadTimes(GetCurrentThread(), &created, &exited, &kernel, &user)) return 0.0;
+	ULARGE_INTEGER kernelTime, userTime;
+	kernelTime.LowPart = kernel.dwLowDateTime;
+	kernelTime.HighPart = kernel.dwHighDateTime;
+	userTime.LowPart = user.dwLowDateTime;
+	userTime.HighPart = user.dwHighDateTime;
+	return (kernelTime.QuadPart + userTime.QuadPart) / 1e7;	// 100 ns units
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+	timespec now;
+	if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0) return 0.0;
+	return now.tv_sec + now.tv_nsec / 1e9;
+#else
+	return 0.0;
+#endif
+}
+
+//------------------------------- buildTree ----------------------------------
+// Inserts the strings of one record into T in order
+void buildTree(BinTree& T, const vector<string>& record)
+{
+	for (const string& s : record)
+	{
+		NodeData* ptr = new NodeData(s);
+		if (!T.insert(ptr))
+			delete ptr;                       // duplicate case, not inserted
+	}
+}
+
+//------------------------------- runRecord ----------------------------------
+// Runs the lab2 checks on one record and writes the results to out. firstRecord and previousRecord are the
+// strings of the file's first record and of the record before this one, the same record for the first one
+void runRecord(const vector<string>& record, const vector<string>& firstRecord,
+	const vector<string>& previousRecord, ostream& out)
+{
+	static const char* const queries[] = { "and", "not", "sss", "tttt", "ooo", "y" };
+
+	out << "Initial data:" << endl << "  ";
+	for (const string& s : record)
+	{
+		out << s << ' ';
+	}
+	out << "$$ " << endl;
+	BinTree T, T2, first, dup;
+	buildTree(T, record);
+	if (T.isEmpty()) return;                  // copying an empty tree is not supported
+	buildTree(first, firstRecord);
+	buildTree(dup, previousRecord);
+	out << "Tree Inorder:" << endl << T;      // operator<< does endl
+	T.displaySideways(out);
+
+	NodeData* p;
+	for (int i = 0; i < 3; i++)
+	{
+		bool found = T.retrieve(NodeData(queries[i]), p);
+		out << "Retrieve --> " << queries[i] << ":  " << (found ? "found" : "not found") << endl;
+	}
+	for (const char* query : queries)
+	{
+		out << "Height    --> " << query << ":  " << T.getHeight(NodeData(query)) << endl;
+	}
+
+	T2 = T;
+	out << "T == T2?     " << (T == T2 ? "equal" : "not equal") << endl;
+	out << "T != first?  " << (T != first ? "not equal" : "equal") << endl;
+	out << "T == dup?    " << (T == dup ? "equal" : "not equal") << endl;
+
+	// the array needs a trailing nullptr for arrayToBSTree
+	vector<NodeData*> ndArray(record.size() + 1, nullptr);
+	T.bstreeToArray(ndArray.data());
+	T.arrayToBSTree(ndArray.data());
+	T.displaySideways(out);
+	out << "---------------------------------------------------------------" << endl;
+}
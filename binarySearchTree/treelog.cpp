@@ -0,0 +1,401 @@
+// ------------------------------------------------ treelog.cpp -------------------------------------------------------
+// Creation Date: 10/19/2026
+// --------------------------------------------------------------------------------------------------------------------
+// Purpose - Write-ahead log and checkpoints for a binary tree
+// --------------------------------------------------------------------------------------------------------------------
+// Log records are "I <length> <key>\n" for an insert and "C\n" for makeEmpty, checkpoint entries are
+// "<length> <key>\n".  Keys are length prefixed so they may hold any bytes.  Replay stops at the first record that
+// is cut short, which is where a crash during a write leaves the log.
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "treelog.h"
+#include "bintree.h"
+#include <vector>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+const int DEFAULT_CHECKPOINT_INTERVAL = 100000;
+
+// ------------------------------------readFile-----------------------------------------------
+// Description: reads a whole file into contents, returns false if it does not exist
+// ---------------------------------------------------------------------------------------------------
+static bool readFile(const string& path, string& contents)
+{
+	ifstream in(path, ios::binary);
+	if (!in) return false;
+	contents.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+	return true;
+}
+
+// ------------------------------------readNumber-----------------------------------------------
+// Description: reads a decimal number at pos followed by the given terminator and moves pos past both
+// ---------------------------------------------------------------------------------------------------
+static bool readNumber(const string& text, size_t& pos, char terminator, uint64_t& value)
+{
+	size_t start = pos;
+	value = 0;
+	while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9')
+	{
+		value = value * 10 + (text[pos] - '0');
+		pos++;
+	}
+	if (pos == start || pos >= text.size() || text[pos] != terminator) return false;
+	pos++;
+	return true;
+}
+
+// ------------------------------------readKey-----------------------------------------------
+// Description: reads "<length> <key>\n" at pos and moves pos past it
+// ---------------------------------------------------------------------------------------------------
+static bool readKey(const string& text, size_t& pos, string& key)
+{
+	uint64_t length;
+	if (!readNumber(text, pos, ' ', length)) return false;
+	if (length >= text.size() - pos || text[pos + length] != '\n') return false;
+	key.assign(text, pos, length);
+	pos += length + 1;
+	return true;
+}
+
+// ------------------------------------appendKey-----------------------------------------------
+// Description: appends "<length> <key>\n" to out
+// ---------------------------------------------------------------------------------------------------
+static void appendKey(string& out, const string& key)
+{
+	out += to_string(key.size());
+	out += ' ';
+	out += key;
+	out += '\n';
+}
+
+// ------------------------------------TreeLog-----------------------------------------------
+// Description: constructor for the log, no files are opened until open is called
+// ---------------------------------------------------------------------------------------------------
+TreeLog::TreeLog()
+{
+	this->tree = nullptr;
+	this->generation = 0;
+	this->checkpointInterval = DEFAULT_CHECKPOINT_INTERVAL;
+	this->recordsSinceCheckpoint = 0;
+	this->logFile = nullptr;
+	this->appendedCount = 0;
+	this->durableCount = 0;
+	this->stopping = false;
+	this->failed = false;
+}
+
+// ------------------------------------~TreeLog-----------------------------------------------
+// Description: destructor, calls close so every appended record reaches the disk
+// ---------------------------------------------------------------------------------------------------
+TreeLog::~TreeLog()
+{
+	close();
+}
+
+// ------------------------------------open-----------------------------------------------
+// Description: restores the tree from the checkpoint and log under basePath, then attaches the tree so
+// later changes are logged. Returns false if the files could not be read or the log could not be opened
+// ---------------------------------------------------------------------------------------------------
+bool TreeLog::open(const string & basePath, BinTree & tree)
+{
+	if (this->tree != nullptr) return false;
+	this->logPath = basePath + ".wal";
+	this->checkpointPath = basePath + ".ckpt";
+	this->generation = 0;
+	this->failed = false;
+	this->stopping = false;
+	if (!recover(tree)) return false;
+
+	this->writer = std::thread(&TreeLog::writerLoop, this);
+	this->tree = &tree;
+	tree.attachLog(this);
+
+	// fold the replayed log into a fresh checkpoint so a torn tail is never appended to
+	if (!checkpoint())
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+// ------------------------------------close-----------------------------------------------
+// Description: waits for pending records, stops the writer thread and detaches the tree
+// ---------------------------------------------------------------------------------------------------
+void TreeLog::close()
+{
+	if (this->writer.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> guard(this->lock);
+			this->stopping = true;
+		}
+		this->writerWake.notify_one();
+		this->writer.join();
+	}
+	if (this->logFile != nullptr)
+	{
+		fclose(this->logFile);
+		this->logFile = nullptr;
+	}
+	if (this->tree != nullptr)
+	{
+		BinTree* attached = this->tree;
+		this->tree = nullptr;
+		attached->attachLog(nullptr);
+	}
+}
+
+// ------------------------------------logInsert-----------------------------------------------
+// Description: queues an insert record, called by BinTree after a successful insert
+// ---------------------------------------------------------------------------------------------------
+void TreeLog::logInsert(const NodeData & data)
+{
+	string record = "I ";
+	appendKey(record, data.getData());
+	append(record);
+}
+
+// ------------------------------------logClear-----------------------------------------------
+// Description: queues a record that the tree was emptied, called by BinTree
+// ---------------------------------------------------------------------------------------------------
+void TreeLog::logClear()
+{
+	append("C\n");
+}
+
+// ------------------------------------flush-----------------------------------------------
+// Description: blocks until every queued record is on disk, returns false if a write has failed
+// ---------------------------------------------------------------------------------------------------
+bool TreeLog::flush()
+{
+	std::unique_lock<std::mutex> guard(this->lock);
+	this->durableWake.wait(guard, [this] { return this->durableCount == this->appendedCount || this->failed; });
+	return !this->failed;
+}
+
+// ------------------------------------checkpoint-----------------------------------------------
+// Description: writes the sorted contents of the attached tree and starts a new empty log
+// ---------------------------------------------------------------------------------------------------
+bool TreeLog::checkpoint()
+{
+	if (this->tree == nullptr || !flush()) return false;
+	string contents;
+	int count = this->tree->findPrefix("", [&contents](const NodeData& data)
+	{
+		appendKey(contents, data.getData());
+	});
+	string header = "CKPT " + to_string(this->generation + 1) + " " + to_string(count) + "\n";
+	if (!writeFileAtomically(this->checkpointPath, header + contents)) return false;
+
+	// a crash from here until the new log is in place leaves an older generation log, which recovery skips
+	this->generation++;
+	if (!startLog())
+	{
+		// later records would still go to the old log, which recovery now skips, so stop reporting success
+		std::lock_guard<std::mutex> guard(this->lock);
+		this->failed = true;
+		return false;
+	}
+	this->recordsSinceCheckpoint = 0;
+	return true;
+}
+
+// ------------------------------------checkpointDue-----------------------------------------------
+// Description: true once the log holds at least the checkpoint interval worth of records
+// ---------------------------------------------------------------------------------------------------
+bool TreeLog::checkpointDue() const
+{
+	return this->recordsSinceCheckpoint >= this->checkpointInterval;
+}
+
+// ------------------------------------setCheckpointInterval-----------------------------------------------
+// Description: sets how many records checkpointDue waits for
+// ---------------------------------------------------------------------------------------------------
+void TreeLog::setCheckpointInterval(int records)
+{
+	this->checkpointInterval = records;
+}
+
+
+// utility functions
+
+// ------------------------------------writerLoop-----------------------------------------------
+// Description: body of the writer thread, writes and syncs one batch of pending records at a time
+// ---------------------------------------------------------------------------------------------------
+void TreeLog::writerLoop()
+{
+	string batch;
+	std::unique_lock<std::mutex> guard(this->lock);
+	while (true)
+	{
+		this->writerWake.wait(guard, [this] { return this->stopping || !this->pending.empty(); });
+		if (this->pending.empty()) break;			// stopping with nothing left to write
+
+		// everything queued while the last batch was syncing goes out together
+		batch.swap(this->pending);
+		uint64_t batchEnd = this->appendedCount;
+		FILE* file = this->logFile;
+		guard.unlock();
+
+		bool written = file != nullptr
+			&& fwrite(batch.data(), 1, batch.size(), file) == batch.size()
+			&& syncFile(file);
+		batch.clear();
+
+		guard.lock();
+		if (written)
+		{
+			this->durableCount = batchEnd;
+		} else
+		{
+			this->failed = true;
+		}
+		this->durableWake.notify_all();
+	}
+}
+
+// ------------------------------------append-----------------------------------------------
+// Description: adds an encoded record to the pending buffer and wakes the writer
+// ---------------------------------------------------------------------------------------------------
+void TreeLog::append(const string & record)
+{
+	{
+		std::lock_guard<std::mutex> guard(this->lock);
+		this->pending += record;
+		this->appendedCount++;
+	}
+	this->recordsSinceCheckpoint++;
+	this->writerWake.notify_one();
+}
+
+// ------------------------------------recover-----------------------------------------------
+// Description: loads the checkpoint into the tree with a balanced build, then replays the log
+// ---------------------------------------------------------------------------------------------------
+bool TreeLog::recover(BinTree & tree)
+{
+	string text;
+	size_t pos = 0;
+	uint64_t value;
+	bool haveCheckpoint = readFile(this->checkpointPath, text);
+	if (haveCheckpoint)
+	{
+		if (text.compare(0, 5, "CKPT ") != 0) return false;
+		pos = 5;
+		uint64_t count;
+		if (!readNumber(text, pos, ' ', value) || !readNumber(text, pos, '\n', count)) return false;
+		this->generation = value;
+		vector<NodeData*> keys;
+		string key;
+		while (keys.size() < count && readKey(text, pos, key))
+		{
+			keys.push_back(new NodeData(key));
+		}
+		bool complete = keys.size() == count;
+		keys.push_back(nullptr);
+		tree.arrayToBSTree(keys.data());		// takes the keys and nulls the array
+		if (!complete) return false;
+	}
+
+	if (!readFile(this->logPath, text)) return true;
+	pos = 4;
+	if (text.compare(0, 4, "WAL ") != 0 || !readNumber(text, pos, '\n', value)) return true;
+	if (value < this->generation) return true;	// superseded by the checkpoint
+	if (value > this->generation) return false;	// the checkpoint this log follows is missing
+	this->generation = value;
+	string key;
+	while (pos < text.size())
+	{
+		if (text.compare(pos, 2, "C\n") == 0)
+		{
+			tree.makeEmpty();
+			pos += 2;
+		} else if (text.compare(pos, 2, "I ") == 0)
+		{
+			pos += 2;
+			if (!readKey(text, pos, key)) break;
+			NodeData* data = new NodeData(key);
+			if (!tree.insert(data))
+			{
+				delete data;
+			}
+		} else
+		{
+			break;
+		}
+	}
+	return true;
+}
+
+// ------------------------------------startLog-----------------------------------------------
+// Description: replaces the log with an empty one for the current generation and opens it for appending
+// ---------------------------------------------------------------------------------------------------
+bool TreeLog::startLog()
+{
+	// the old log is drained by flush, close it first since Windows cannot replace a file that is open
+	FILE* previous;
+	{
+		std::lock_guard<std::mutex> guard(this->lock);
+		previous = this->logFile;
+		this->logFile = nullptr;
+	}
+	if (previous != nullptr)
+	{
+		fclose(previous);
+	}
+	if (!writeFileAtomically(this->logPath, "WAL " + to_string(this->generation) + "\n")) return false;
+	FILE* file = fopen(this->logPath.c_str(), "ab");
+	{
+		std::lock_guard<std::mutex> guard(this->lock);
+		this->logFile = file;
+	}
+	return file != nullptr;
+}
+
+// ------------------------------------writeFileAtomically-----------------------------------------------
+// Description: writes contents to a temporary file, syncs it and renames it over path
+// ---------------------------------------------------------------------------------------------------
+bool TreeLog::writeFileAtomically(const string & path, const string & contents)
+{
+	string temporaryPath = path + ".tmp";
+	FILE* file = fopen(temporaryPath.c_str(), "wb");
+	if (file == nullptr) return false;
+	bool written = fwrite(contents.data(), 1, contents.size(), file) == contents.size() && syncFile(file);
+	fclose(file);
+	if (!written) return false;
+#ifdef _WIN32
+	// rename does not replace an existing file on Windows, MoveFileEx does so in one step
+	return MoveFileExA(temporaryPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+	if (rename(temporaryPath.c_str(), path.c_str()) != 0) return false;
+
+	// the rename itself is only durable once the directory holding the file is synced
+	size_t slash = path.find_last_of('/');
+	string directory = (slash == string::npos) ? "." : (slash == 0) ? "/" : path.substr(0, slash);
+	int descriptor = ::open(directory.c_str(), O_RDONLY);
+	if (descriptor < 0) return false;
+	bool synced = fsync(descriptor) == 0;
+	::close(descriptor);
+	return synced;
+#endif
+}
+
+// ------------------------------------syncFile-----------------------------------------------
+// Description: flushes the stdio buffer and forces the file contents to disk
+// ---------------------------------------------------------------------------------------------------
+bool TreeLog::syncFile(FILE * file)
+{
+	if (fflush(file) != 0) return false;
+#ifdef _WIN32
+	return _commit(_fileno(file)) == 0;
+#else
+	return fsync(fileno(file)) == 0;
+#endif
+}
@@ -0,0 +1,137 @@
+// ------------------------------------------------ treelog.h -------------------------------------------------------
+// Creation Date: 10/19/2026
+// --------------------------------------------------------------------------------------------------------------------
+// Purpose - Write-ahead log and checkpoints for a binary tree
+// --------------------------------------------------------------------------------------------------------------------
+// Every successful insert and every makeEmpty of an attached tree is appended to a log file.  Appends only copy
+// the record into a memory buffer, a background thread writes the buffer out and syncs it to disk, so many
+// records share one sync (group commit).  A checkpoint writes the sorted contents of the tree and starts a new,
+// empty log, which bounds how much has to be replayed on restart.
+//
+// Files are <base>.ckpt and <base>.wal.  Both start with a generation number, a log older than the checkpoint
+// is left over from a crash during checkpoint and is ignored.  Recovery restores the contents of the tree, not
+// its shape.  The tree itself is not thread safe, insert, makeEmpty and checkpoint must come from one thread.
+// --------------------------------------------------------------------------------------------------------------------
+#ifndef TREELOG_H
+#define TREELOG_H
+#include "nodedata.h"
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+class BinTree;
+
+class TreeLog
+{
+public:
+
+	// ------------------------------------TreeLog-----------------------------------------------
+	// Description: constructor for the log, no files are opened until open is called
+	// ---------------------------------------------------------------------------------------------------
+	TreeLog();
+
+	// ------------------------------------~TreeLog-----------------------------------------------
+	// Description: destructor, calls close so every appended record reaches the disk
+	// ---------------------------------------------------------------------------------------------------
+	~TreeLog();
+
+	// ------------------------------------open-----------------------------------------------
+	// Description: restores the tree from the checkpoint and log under basePath, then attaches the tree so
+	// later changes are logged. Returns false if the files could not be read or the log could not be opened
+	// ---------------------------------------------------------------------------------------------------
+	bool open(const string& basePath, BinTree& tree);
+
+	// ------------------------------------close-----------------------------------------------
+	// Description: waits for pending records, stops the writer thread and detaches the tree
+	// ---------------------------------------------------------------------------------------------------
+	void close();
+
+	// ------------------------------------logInsert-----------------------------------------------
+	// Description: queues an insert record, called by BinTree after a successful insert
+	// ---------------------------------------------------------------------------------------------------
+	void logInsert(const NodeData&);
+
+	// ------------------------------------logClear-----------------------------------------------
+	// Description: queues a record that the tree was emptied, called by BinTree
+	// ---------------------------------------------------------------------------------------------------
+	void logClear();
+
+	// ------------------------------------flush-----------------------------------------------
+	// Description: blocks until every queued record is on disk, returns false if a write has failed
+	// ---------------------------------------------------------------------------------------------------
+	bool flush();
+
+	// ------------------------------------checkpoint-----------------------------------------------
+	// Description: writes the sorted contents of the attached tree and starts a new empty log
+	// ---------------------------------------------------------------------------------------------------
+	bool checkpoint();
+
+	// ------------------------------------checkpointDue-----------------------------------------------
+	// Description: true once the log holds at least the checkpoint interval worth of records
+	// ---------------------------------------------------------------------------------------------------
+	bool checkpointDue() const;
+
+	// ------------------------------------setCheckpointInterval-----------------------------------------------
+	// Description: sets how many records checkpointDue waits for
+	// ---------------------------------------------------------------------------------------------------
+	void setCheckpointInterval(int records);
+
+private:
+
+	TreeLog(const TreeLog&) = delete;
+	TreeLog& operator=(const TreeLog&) = delete;
+
+	BinTree* tree;							// attached tree, nullptr when closed
+	string logPath;							// <base>.wal
+	string checkpointPath;					// <base>.ckpt
+	uint64_t generation;					// generation of the current checkpoint and log
+	int checkpointInterval;					// records between checkpoints
+	int recordsSinceCheckpoint;				// records appended since the last checkpoint
+
+	std::mutex lock;						// guards everything below
+	std::condition_variable writerWake;		// signals the writer that records are pending or to stop
+	std::condition_variable durableWake;	// signals flush that a batch reached the disk
+	std::thread writer;						// background writer thread
+	FILE* logFile;							// open log, appended to only by the writer
+	string pending;							// records not yet handed to the writer
+	uint64_t appendedCount;					// records queued since open
+	uint64_t durableCount;					// records known to be on disk
+	bool stopping;							// writer should exit once pending is empty
+	bool failed;							// a write or sync has failed
+
+// utility functions
+
+	// ------------------------------------writerLoop-----------------------------------------------
+	// Description: body of the writer thread, writes and syncs one batch of pending records at a time
+	// ---------------------------------------------------------------------------------------------------
+	void writerLoop();
+
+	// ------------------------------------append-----------------------------------------------
+	// Description: adds an encoded record to the pending buffer and wakes the writer
+	// ---------------------------------------------------------------------------------------------------
+	void append(const string& record);
+
+	// ------------------------------------recover-----------------------------------------------
+	// Description: loads the checkpoint into the tree with a balanced build, then replays the log
+	// ---------------------------------------------------------------------------------------------------
+	bool recover(BinTree&);
+
+	// ------------------------------------startLog-----------------------------------------------
+	// Description: replaces the log with an empty one for the current generation and opens it for appending
+	// ---------------------------------------------------------------------------------------------------
+	bool startLog();
+
+	// ------------------------------------writeFileAtomically-----------------------------------------------
+	// Description: writes contents to a temporary file, syncs it and renames it over path
+	// ---------------------------------------------------------------------------------------------------
+	static bool writeFileAtomically(const string& path, const string& contents);
+
+	// ------------------------------------syncFile-----------------------------------------------
+	// Description: flushes the stdio buffer and forces the file contents to disk
+	// ---------------------------------------------------------------------------------------------------
+	static bool syncFile(FILE*);
+
+};
+#endif
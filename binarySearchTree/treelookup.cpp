@@ -0,0 +1,123 @@
+// ------------------------------------------------ treelookup.cpp -------------------------------------------------------
+// Creation Date: 10/19/2026
+// --------------------------------------------------------------------------------------------------------------------
+// Purpose - Measures interleaved coroutine lookups against plain retrieve
+// --------------------------------------------------------------------------------------------------------------------
+// Builds a tree of random keys too large for the cache, then looks up the same queries, half of them present, once
+// with retrieve one at a time and once with asyncRetrieve, running a group of lookups together through one
+// LookupScheduler so their cache misses overlap.  Both passes must find the same values, the program fails if they
+// do not.  Needs C++20 coroutines, without them only the retrieve pass runs.
+//
+// usage: treelookup [keys] [lookups] [group]
+//   keys       defaults to 2000000
+//   lookups    defaults to 1000000
+//   group      lookups run together, defaults to 16
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "bintree.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+//global function prototypes
+size_t serialLookups(const BinTree&, const vector<NodeData>&, vector<NodeData*>&);
+#if defined(__cpp_impl_coroutine)
+size_t interleavedLookups(const BinTree&, const vector<NodeData>&, size_t, vector<NodeData*>&);
+#endif
+
+int main(int argc, char* argv[])
+{
+	size_t keyCount = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 2000000;
+	size_t lookupCount = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 1000000;
+	size_t groupSize = (argc > 3) ? strtoul(argv[3], nullptr, 10) : 16;
+	if (keyCount == 0) keyCount = 1;
+	if (groupSize == 0) groupSize = 1;
+
+	mt19937_64 random(7);
+	vector<string> keys;
+	keys.reserve(keyCount);
+	BinTree tree;
+	for (size_t i = 0; i < keyCount; i++)
+	{
+		keys.push_back("key" + to_string(random()));
+		NodeData* ptr = new NodeData(keys.back());
+		if (!tree.insert(ptr))
+			delete ptr;                       // duplicate case, not inserted
+	}
+	vector<NodeData> queries;
+	queries.reserve(lookupCount);
+	for (size_t i = 0; i < lookupCount; i++)
+	{
+		if (i % 2 == 0)
+		{
+			queries.emplace_back(keys[random() % keyCount]);
+		} else
+		{
+			queries.emplace_back("miss" + to_string(i));
+		}
+	}
+
+	vector<NodeData*> serialActual(lookupCount, nullptr);
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	size_t found = serialLookups(tree, queries, serialActual);
+	double serialSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	printf("retrieve          %zu lookups, %zu found, %.3f s\n", lookupCount, found, serialSeconds);
+
+#if defined(__cpp_impl_coroutine)
+	vector<NodeData*> interleavedActual(lookupCount, nullptr);
+	start = chrono::steady_clock::now();
+	size_t interleavedFound = interleavedLookups(tree, queries, groupSize, interleavedActual);
+	double interleavedSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	printf("asyncRetrieve x%-3zu%zu lookups, %zu found, %.3f s\n", groupSize, lookupCount, interleavedFound,
+		interleavedSeconds);
+	if (interleavedFound != found || interleavedActual != serialActual)
+	{
+		printf("interleaved lookups do not match retrieve\n");
+		return 1;
+	}
+#else
+	printf("asyncRetrieve     n/a, built without C++20 coroutines\n");
+#endif
+	return 0;
+}
+
+//------------------------------- serialLookups ----------------------------------
+// Retrieves every query in turn, stores what each found in actual and returns how many were found
+size_t serialLookups(const BinTree& tree, const vector<NodeData>& queries, vector<NodeData*>& actual)
+{
+	size_t found = 0;
+	for (size_t i = 0; i < queries.size(); i++)
+	{
+		if (tree.retrieve(queries[i], actual[i])) found++;
+	}
+	return found;
+}
+
+#if defined(__cpp_impl_coroutine)
+//------------------------------- interleavedLookups ----------------------------------
+// Runs the queries groupSize at a time through one scheduler, stores what each found in actual and returns
+// how many were found.  Collecting each group's results frees its ids for the next group
+size_t interleavedLookups(const BinTree& tree, const vector<NodeData>& queries, size_t groupSize,
+	vector<NodeData*>& actual)
+{
+	size_t found = 0;
+	LookupScheduler scheduler;
+	vector<int> ids;
+	for (size_t begin = 0; begin < queries.size(); begin += groupSize)
+	{
+		size_t end = min(begin + groupSize, queries.size());
+		ids.clear();
+		for (size_t i = begin; i < end; i++)
+		{
+			ids.push_back(scheduler.add(tree.asyncRetrieve(queries[i], actual[i])));
+		}
+		scheduler.run();
+		for (int id : ids)
+		{
+			if (scheduler.result(id)) found++;
+		}
+	}
+	return found;
+}
+#endif
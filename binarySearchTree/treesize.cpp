@@ -0,0 +1,106 @@
+// ------------------------------------------------ treesize.cpp -------------------------------------------------------
+// Creation Date: 10/19/2026
+// --------------------------------------------------------------------------------------------------------------------
+// Purpose - Measures memory per key of BinTree and CompactBinTree
+// --------------------------------------------------------------------------------------------------------------------
+// Inserts the same short random keys into each tree and prints heap bytes per key, taken from malloc statistics
+// before and after building the tree, so allocator overhead is counted.  CompactBinTree also reports its own
+// bytesUsed.  Malloc statistics are only read on glibc, elsewhere the heap column shows n/a.
+//
+// usage: treesize [keys]
+//   keys       defaults to 10000000
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "bintree.h"
+#include "compacttree.h"
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define HAVE_HEAP_STATS 1
+#endif
+
+//global function prototypes
+bool heapBytes(size_t&);
+void printHeap(const char*, size_t, size_t, bool);
+
+int main(int argc, char* argv[])
+{
+	size_t keyCount = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 10000000;
+	if (keyCount == 0) keyCount = 1;
+
+	// four letters and a number, small enough for the short string buffer and for CompactBinTree's inline keys
+	vector<string> keys;
+	keys.reserve(keyCount);
+	mt19937_64 random(5);
+	for (size_t i = 0; i < keyCount; i++)
+	{
+		string key(4, ' ');
+		for (char& letter : key)
+		{
+			letter = (char)('a' + random() % 26);
+		}
+		keys.push_back(key + to_string(i % 1000));
+	}
+
+	size_t before = 0;
+	size_t after = 0;
+	{
+		bool measured = heapBytes(before);
+		BinTree tree;
+		size_t inserted = 0;
+		for (const string& key : keys)
+		{
+			NodeData* ptr = new NodeData(key);
+			if (tree.insert(ptr))
+			{
+				inserted++;
+			} else
+			{
+				delete ptr;                   // duplicate case, not inserted
+			}
+		}
+		measured = heapBytes(after) && measured;
+		printHeap("BinTree", inserted, after - before, measured);
+	}
+	{
+		bool measured = heapBytes(before);
+		CompactBinTree tree;
+		tree.reserve(keys.size());
+		for (const string& key : keys)
+		{
+			tree.insert(NodeData(key));
+		}
+		measured = heapBytes(after) && measured;
+		printHeap("CompactBinTree", tree.getSize(), after - before, measured);
+		printf("  bytesUsed %.1f bytes/key\n", (double)tree.bytesUsed() / tree.getSize());
+	}
+	return 0;
+}
+
+//------------------------------- heapBytes ----------------------------------
+// Reads the bytes currently allocated from the heap, returns false where malloc statistics are unavailable
+bool heapBytes(size_t& bytes)
+{
+#ifdef HAVE_HEAP_STATS
+	bytes = mallinfo2().uordblks;
+	return true;
+#else
+	bytes = 0;
+	return false;
+#endif
+}
+
+//------------------------------- printHeap ----------------------------------
+// Prints the key count and heap bytes per key of one tree
+void printHeap(const char* name, size_t keyCount, size_t bytes, bool measured)
+{
+	if (measured)
+	{
+		printf("%-15s %zu keys, heap %.1f bytes/key\n", name, keyCount, (double)bytes / keyCount);
+	} else
+	{
+		printf("%-15s %zu keys, heap n/a\n", name, keyCount);
+	}
+}